@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+struct AtmosPoint {
+    double H, rho, a, T;
+};
+
+class AtmosphereGrid {
+public:
+    bool loadTable(const std::string& filename, double step = 1.0) {
+        nodes.clear();
+        table.clear();
+
+        std::ifstream in(filename.c_str());
+        if (!in.is_open()) return false;
+
+        std::string line;
+        if (!std::getline(in, line)) return false;
+
+        std::vector<AtmosPoint> points;
+        while (std::getline(in, line)) {
+            size_t p = line.find("//");
+            if (p != std::string::npos) line = line.substr(0, p);
+
+            std::vector<double> v;
+            std::stringstream ss(line);
+            std::string token;
+            while (std::getline(ss, token, ',')) {
+                double x = 0.0;
+                if (!toDouble(token, x)) break;
+                v.push_back(x);
+            }
+            if (v.size() < 2) continue;
+
+            AtmosPoint pt;
+            pt.H = v[0];
+            pt.rho = v[1];
+            pt.T = (v.size() >= 4) ? v[3] : isaTemperature(pt.H);
+            pt.a = (v.size() >= 3) ? v[2] : std::sqrt(1.4 * 287.05 * pt.T);
+            points.push_back(pt);
+        }
+
+        return build(points, step);
+    }
+
+    bool build(const std::vector<AtmosPoint>& points, double step = 1.0) {
+        nodes.clear();
+        table.clear();
+        if (points.size() < 2 || step <= 0.0) return false;
+        for (size_t i = 1; i < points.size(); ++i) {
+            if (points[i].H < points[i - 1].H) return false;
+        }
+
+        size_t count = points.size();
+        double H_max = points[count - 1].H;
+        H0 = points[0].H;
+        if (H_max <= H0) return false;
+
+        int n = (int)std::ceil((H_max - H0) / step) + 1;
+        double node_step = (H_max - H0) / (n - 1);
+        inv_step = 1.0 / node_step;
+        last = n - 1;
+
+        nodes.resize(n + 1);
+        size_t k = 0;
+        for (int i = 0; i <= n; ++i) {
+            double H = (i >= last) ? H_max : H0 + i * node_step;
+            while (k < count - 2 && H > points[k + 1].H) k++;
+            const AtmosPoint& p0 = points[k];
+            const AtmosPoint& p1 = points[k + 1];
+            nodes[i].rho = interpolate(H, p0.H, p1.H, p0.rho, p1.rho);
+            nodes[i].a = interpolate(H, p0.H, p1.H, p0.a, p1.a);
+            nodes[i].T = interpolate(H, p0.H, p1.H, p0.T, p1.T);
+        }
+
+        table = points;
+        return true;
+    }
+
+    bool at(double H, double& rho, double& a, double& T) const {
+        if (lookup(&H, 1, &rho, &a, &T)) return true;
+        rho = a = T = 0.0;
+        return false;
+    }
+
+    bool lookup(const double* H, size_t count, double* rho, double* a, double* T) const {
+        if (nodes.empty()) return false;
+
+        const Node* grid = nodes.data();
+        const double h0 = H0, scale = inv_step, top = (double)last;
+        for (size_t k = 0; k < count; ++k) {
+            double x = std::min(std::max((H[k] - h0) * scale, 0.0), top);
+            int i = (int)x;
+            double t = x - i;
+            const Node& n0 = grid[i];
+            const Node& n1 = grid[i + 1];
+            rho[k] = n0.rho + (n1.rho - n0.rho) * t;
+            a[k] = n0.a + (n1.a - n0.a) * t;
+            T[k] = n0.T + (n1.T - n0.T) * t;
+        }
+        return true;
+    }
+
+    bool atLinear(double H, double& rho, double& a, double& T) const {
+        if (table.empty()) {
+            rho = a = T = 0.0;
+            return false;
+        }
+
+        const AtmosPoint* p = &table.front();
+        if (H >= table.back().H) {
+            p = &table.back();
+        }
+        else if (H > table.front().H) {
+            for (size_t i = 1; i < table.size(); ++i) {
+                if (H <= table[i].H) {
+                    const AtmosPoint& p0 = table[i - 1];
+                    const AtmosPoint& p1 = table[i];
+                    rho = interpolate(H, p0.H, p1.H, p0.rho, p1.rho);
+                    a = interpolate(H, p0.H, p1.H, p0.a, p1.a);
+                    T = interpolate(H, p0.H, p1.H, p0.T, p1.T);
+                    return true;
+                }
+            }
+        }
+        rho = p->rho;
+        a = p->a;
+        T = p->T;
+        return true;
+    }
+
+    bool empty() const { return nodes.empty(); }
+
+private:
+    struct Node {
+        double rho, a, T;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<AtmosPoint> table;
+    double H0 = 0.0;
+    double inv_step = 1.0;
+    int last = 0;
+
+    static double interpolate(double x, double x0, double x1, double y0, double y1) {
+        if (std::fabs(x1 - x0) < 1e-9) return y0;
+        return y0 + (x - x0) * (y1 - y0) / (x1 - x0);
+    }
+
+    static double isaTemperature(double H) {
+        return (H < 11000.0) ? 288.15 - 0.0065 * H : 216.65;
+    }
+
+    static bool toDouble(const std::string& s, double& out) {
+        const char* begin = s.c_str();
+        char* endp = 0;
+        out = std::strtod(begin, &endp);
+        if (endp == begin) return false;
+        while (*endp == ' ' || *endp == '\t' || *endp == '\r' || *endp == '\n') endp++;
+        return *endp == '\0';
+    }
+};
@@ -1,12 +1,16 @@
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <queue>
 #include <vector>
 #include <fstream>
 #include <string>
 
+#include "atmosphere_grid.h"
+
 using namespace std;
 
 const double MASS0 = 155000.0;
@@ -26,6 +30,8 @@ const double DEG_TO_RAD = 57.3;
 const double MAX_VERTICAL_SPEED = 8.0;
 const double MAX_CLIMB_ANGLE = 15.0;
 const double MIN_CLIMB_SPEED_KMH = 350.0;
+const double COMBINED_CLIMB_RATE = 6.0;
+const double COMBINED_ACCEL_KMH_S = 20.0;
 
 enum OptimizationCriterion {
     MIN_TIME = 1,
@@ -38,10 +44,6 @@ enum ManeuverType {
     ACCELERATION_CLIMB = 3
 };
 
-struct AtmosPoint {
-    double H, rho, a, T;
-};
-
 static const AtmosPoint ATMOS_TABLE[] = {
     {0.0,     1.22500, 340.294, 288.150},
     {500.0,   1.16727, 338.370, 284.900},
@@ -59,32 +61,61 @@ static const AtmosPoint ATMOS_TABLE[] = {
 };
 const int ATMOS_N = 13;
 
-double interpolate(double x, double x0, double x1, double y0, double y1) {
-    if (abs(x1 - x0) < 1e-9) return y0;
-    return y0 + (x - x0) * (y1 - y0) / (x1 - x0);
+static AtmosphereGrid ATMOS_GRID;
+
+vector<AtmosPoint> builtin_atmosphere() {
+    return vector<AtmosPoint>(ATMOS_TABLE, ATMOS_TABLE + ATMOS_N);
+}
+
+void init_atmosphere() {
+    if (ATMOS_GRID.loadTable("atmosphere.csv")) {
+        cout << "Atmosphere: atmosphere.csv\n";
+    }
+    else {
+        ATMOS_GRID.build(builtin_atmosphere());
+        cout << "Atmosphere: built-in table\n";
+    }
 }
 
 void atmosphere(double H, double& rho, double& a_sound) {
-    if (H <= ATMOS_TABLE[0].H) {
-        rho = ATMOS_TABLE[0].rho;
-        a_sound = ATMOS_TABLE[0].a;
-        return;
-    }
-    if (H >= ATMOS_TABLE[ATMOS_N - 1].H) {
-        rho = ATMOS_TABLE[ATMOS_N - 1].rho;
-        a_sound = ATMOS_TABLE[ATMOS_N - 1].a;
-        return;
-    }
-
-    for (int i = 0; i < ATMOS_N - 1; i++) {
-        if (H >= ATMOS_TABLE[i].H && H < ATMOS_TABLE[i + 1].H) {
-            rho = interpolate(H, ATMOS_TABLE[i].H, ATMOS_TABLE[i + 1].H,
-                ATMOS_TABLE[i].rho, ATMOS_TABLE[i + 1].rho);
-            a_sound = interpolate(H, ATMOS_TABLE[i].H, ATMOS_TABLE[i + 1].H,
-                ATMOS_TABLE[i].a, ATMOS_TABLE[i + 1].a);
-            return;
-        }
+    if (ATMOS_GRID.empty()) ATMOS_GRID.build(builtin_atmosphere());
+    double T;
+    ATMOS_GRID.at(H, rho, a_sound, T);
+}
+
+void benchmark_atmosphere() {
+    if (ATMOS_GRID.empty()) ATMOS_GRID.build(builtin_atmosphere());
+
+    const size_t count = 1000000;
+    vector<double> H(count), rho(count), a_sound(count), T(count);
+    for (size_t k = 0; k < count; k++) {
+        H[k] = 11000.0 * (double)((k * 7919) % count) / count;
+    }
+
+    vector<double> rho_linear(count), a_linear(count);
+    double T_linear;
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t k = 0; k < count; k++) {
+        ATMOS_GRID.atLinear(H[k], rho_linear[k], a_linear[k], T_linear);
     }
+    auto t1 = chrono::steady_clock::now();
+    ATMOS_GRID.lookup(H.data(), count, rho.data(), a_sound.data(), T.data());
+    auto t2 = chrono::steady_clock::now();
+
+    double max_diff = 0.0;
+    for (size_t k = 0; k < count; k++) {
+        max_diff = max(max_diff, abs(rho[k] - rho_linear[k]));
+        max_diff = max(max_diff, abs(a_sound[k] - a_linear[k]));
+    }
+
+    double ns_linear = chrono::duration<double, nano>(t1 - t0).count() / count;
+    double ns_grid = chrono::duration<double, nano>(t2 - t1).count() / count;
+
+    cout << "\nAtmosphere lookup benchmark (" << count << " points)\n";
+    cout << "Linear scan:  " << ns_linear << " ns/lookup\n";
+    cout << "Uniform grid: " << ns_grid << " ns/lookup\n";
+    cout << "Max difference: " << scientific << max_diff << fixed << "\n";
 }
 
 bool is_in_flight_envelope(double H, double V_kmh) {
@@ -318,8 +349,8 @@ SegmentData calculate_acceleration_climb(double H1, double H2, double V1_ms, dou
     double dH = H2 - H1;
     double dV_kmh = (V2_ms - V1_ms) * 3.6;
 
-    double time_for_climb = dH / 6.0;
-    double time_for_accel = abs(dV_kmh) / 20.0;
+    double time_for_climb = dH / COMBINED_CLIMB_RATE;
+    double time_for_accel = abs(dV_kmh) / COMBINED_ACCEL_KMH_S;
 
     double dt = max(time_for_climb, time_for_accel);
 
@@ -360,6 +391,22 @@ struct TrajectoryResult {
     string name;
 };
 
+void criterion_settings(OptimizationCriterion criterion, vector<double>& power_settings, double& max_vy_factor) {
+    power_settings.clear();
+    if (criterion == MIN_TIME) {
+        power_settings.push_back(1.10);
+        power_settings.push_back(1.05);
+        power_settings.push_back(1.00);
+        max_vy_factor = 1.0;
+    }
+    else {
+        power_settings.push_back(0.90);
+        power_settings.push_back(0.85);
+        power_settings.push_back(0.80);
+        max_vy_factor = 0.70;
+    }
+}
+
 TrajectoryResult solve_trajectory(OptimizationCriterion criterion, string traj_name) {
     TrajectoryResult trajectory;
     trajectory.name = traj_name;
@@ -388,19 +435,7 @@ TrajectoryResult solve_trajectory(OptimizationCriterion criterion, string traj_n
 
     vector<double> power_settings;
     double max_vy_factor;
-
-    if (criterion == MIN_TIME) {
-        power_settings.push_back(1.10);
-        power_settings.push_back(1.05);
-        power_settings.push_back(1.00);
-        max_vy_factor = 1.0;
-    }
-    else {
-        power_settings.push_back(0.90);
-        power_settings.push_back(0.85);
-        power_settings.push_back(0.80);
-        max_vy_factor = 0.70;
-    }
+    criterion_settings(criterion, power_settings, max_vy_factor);
 
     vector<vector<double> > cost_table(N + 1, vector<double>(N + 1, 1e9));
     vector<vector<double> > time_table(N + 1, vector<double>(N + 1, 0.0));
@@ -691,6 +726,260 @@ TrajectoryResult solve_trajectory(OptimizationCriterion criterion, string traj_n
     return trajectory;
 }
 
+struct SearchStats {
+    long edges_total;
+    long edges_evaluated;
+    long nodes_settled;
+};
+
+struct SearchEntry {
+    double f;
+    double g;
+    int from_i, from_j;
+    int to_i, to_j;
+    int maneuver;
+    int ps;
+    bool evaluated;
+    double seg_time;
+    double seg_fuel;
+
+    bool operator>(const SearchEntry& other) const {
+        if (f != other.f) return f > other.f;
+        return ps > other.ps;
+    }
+};
+
+TrajectoryResult solve_trajectory_astar(OptimizationCriterion criterion, string traj_name, int n, SearchStats& stats) {
+    TrajectoryResult trajectory;
+    trajectory.name = traj_name;
+    trajectory.total_time = 0.0;
+    trajectory.total_fuel = 0.0;
+    trajectory.avg_vy = 0.0;
+    trajectory.used_acceleration = 0;
+    trajectory.used_climb = 0;
+    trajectory.used_combined = 0;
+
+    double dH = (H_FINISH - H_START) / n;
+    double dV_ms = (V_FINISH_KMH - V_START_KMH) / n / 3.6;
+
+    vector<double> power_settings;
+    double max_vy_factor;
+    criterion_settings(criterion, power_settings, max_vy_factor);
+
+    double ps_max = *max_element(power_settings.begin(), power_settings.end());
+
+    // Upper bound on thrust: lowest altitude, Mach factor saturated.
+    // Lower bound on thrust: highest altitude, M = 0.
+    // Lower bound on c_p: altitude factor saturated at 11 km, M < 0.5.
+    double P_upper = thrust_single_pd14_nominal(H_START, 1.0) * ENGINE_COUNT * (THRUST_PERCENT / 100.0);
+    double P_lower = thrust_single_pd14_nominal(H_FINISH, 0.0) * ENGINE_COUNT * (THRUST_PERCENT / 100.0);
+
+    vector<double> fuel_rate_min(power_settings.size());
+    for (size_t ps = 0; ps < power_settings.size(); ps++) {
+        double c_p = specific_fuel_consumption(11000.0, 0.0, power_settings[ps]);
+        fuel_rate_min[ps] = c_p * P_lower * power_settings[ps] / 3600.0;
+    }
+
+    double vy_max = max(MAX_VERTICAL_SPEED * max_vy_factor, COMBINED_CLIMB_RATE);
+    double accel_max = max(P_upper * ps_max / MASS0, COMBINED_ACCEL_KMH_S / 3.6);
+    double rate_min = (criterion == MIN_TIME) ? 1.0 : *min_element(fuel_rate_min.begin(), fuel_rate_min.end());
+
+    auto heuristic = [&](int i, int j) {
+        return rate_min * max((n - i) * dH / vy_max, (n - j) * dV_ms / accel_max);
+    };
+
+    auto edge_bound = [&](int maneuver, size_t ps) {
+        double dt;
+        if (maneuver == ACCELERATION) {
+            dt = dV_ms / (P_upper * power_settings[ps] / MASS0);
+        }
+        else if (maneuver == CLIMB) {
+            dt = dH / (MAX_VERTICAL_SPEED * max_vy_factor);
+        }
+        else {
+            dt = max(dH / COMBINED_CLIMB_RATE, dV_ms * 3.6 / COMBINED_ACCEL_KMH_S);
+        }
+        return (criterion == MIN_TIME) ? dt : dt * fuel_rate_min[ps];
+    };
+
+    vector<vector<double> > cost_table(n + 1, vector<double>(n + 1, 1e9));
+    vector<vector<double> > seg_time_table(n + 1, vector<double>(n + 1, 0.0));
+    vector<vector<double> > seg_fuel_table(n + 1, vector<double>(n + 1, 0.0));
+    vector<vector<int> > prev_i(n + 1, vector<int>(n + 1, -1));
+    vector<vector<int> > prev_j(n + 1, vector<int>(n + 1, -1));
+    vector<vector<int> > maneuver_type(n + 1, vector<int>(n + 1, ACCELERATION));
+    vector<vector<bool> > settled(n + 1, vector<bool>(n + 1, false));
+
+    stats.edges_total = (long)power_settings.size() * (3L * n * n + 2L * n);
+    stats.edges_evaluated = 0;
+    stats.nodes_settled = 0;
+
+    priority_queue<SearchEntry, vector<SearchEntry>, greater<SearchEntry> > open;
+
+    SearchEntry start;
+    start.f = heuristic(0, 0);
+    start.g = 0.0;
+    start.from_i = -1;
+    start.from_j = -1;
+    start.to_i = 0;
+    start.to_j = 0;
+    start.maneuver = ACCELERATION;
+    start.ps = -1;
+    start.evaluated = true;
+    start.seg_time = 0.0;
+    start.seg_fuel = 0.0;
+    open.push(start);
+
+    while (!open.empty()) {
+        SearchEntry e = open.top();
+        open.pop();
+
+        if (settled[e.to_i][e.to_j]) continue;
+
+        if (!e.evaluated) {
+            double H1 = H_START + e.from_i * dH;
+            double H2 = H_START + e.to_i * dH;
+            double V1_ms = V_START_KMH / 3.6 + e.from_j * dV_ms;
+            double V2_ms = V_START_KMH / 3.6 + e.to_j * dV_ms;
+            double power_setting = power_settings[e.ps];
+
+            SegmentData seg;
+            if (e.maneuver == ACCELERATION) {
+                seg = calculate_acceleration(H1, V1_ms, V2_ms, MASS0, power_setting);
+            }
+            else if (e.maneuver == CLIMB) {
+                seg = calculate_climb(H1, H2, V1_ms, MASS0, power_setting, max_vy_factor);
+            }
+            else {
+                seg = calculate_acceleration_climb(H1, H2, V1_ms, V2_ms, MASS0, power_setting, max_vy_factor);
+            }
+            stats.edges_evaluated++;
+
+            if (!seg.valid) continue;
+
+            double cost_increment = (criterion == MIN_TIME) ? seg.time : seg.fuel;
+            e.g = cost_table[e.from_i][e.from_j] + cost_increment;
+            e.f = e.g + heuristic(e.to_i, e.to_j);
+            e.evaluated = true;
+            e.seg_time = seg.time;
+            e.seg_fuel = seg.fuel;
+            open.push(e);
+            continue;
+        }
+
+        int i = e.to_i, j = e.to_j;
+        settled[i][j] = true;
+        stats.nodes_settled++;
+        cost_table[i][j] = e.g;
+        seg_time_table[i][j] = e.seg_time;
+        seg_fuel_table[i][j] = e.seg_fuel;
+        prev_i[i][j] = e.from_i;
+        prev_j[i][j] = e.from_j;
+        maneuver_type[i][j] = e.maneuver;
+
+        if (i == n && j == n) break;
+
+        for (int m = ACCELERATION; m <= ACCELERATION_CLIMB; m++) {
+            int ni = (m == ACCELERATION) ? i : i + 1;
+            int nj = (m == CLIMB) ? j : j + 1;
+            if (ni > n || nj > n || settled[ni][nj]) continue;
+
+            for (size_t ps = 0; ps < power_settings.size(); ps++) {
+                SearchEntry next;
+                next.g = e.g + edge_bound(m, ps);
+                next.f = next.g + heuristic(ni, nj);
+                next.from_i = i;
+                next.from_j = j;
+                next.to_i = ni;
+                next.to_j = nj;
+                next.maneuver = m;
+                next.ps = (int)ps;
+                next.evaluated = false;
+                next.seg_time = 0.0;
+                next.seg_fuel = 0.0;
+                open.push(next);
+            }
+        }
+    }
+
+    if (!settled[n][n]) {
+        cout << "ERROR: Path not found!\n";
+        return trajectory;
+    }
+
+    vector<pair<double, double> > path;
+    vector<ManeuverType> path_maneuvers;
+    vector<double> seg_times;
+    vector<double> seg_fuels;
+    int ci = n, cj = n;
+
+    while (ci >= 0 && cj >= 0) {
+        path.push_back(make_pair(H_START + ci * dH, V_START_KMH + cj * dV_ms * 3.6));
+        path_maneuvers.push_back(static_cast<ManeuverType>(maneuver_type[ci][cj]));
+
+        int pi = prev_i[ci][cj];
+        int pj = prev_j[ci][cj];
+        if (pi == -1) break;
+
+        seg_times.push_back(seg_time_table[ci][cj]);
+        seg_fuels.push_back(seg_fuel_table[ci][cj]);
+        trajectory.total_time += seg_time_table[ci][cj];
+        trajectory.total_fuel += seg_fuel_table[ci][cj];
+
+        if (path_maneuvers.back() == ACCELERATION) trajectory.used_acceleration++;
+        else if (path_maneuvers.back() == CLIMB) trajectory.used_climb++;
+        else trajectory.used_combined++;
+
+        ci = pi;
+        cj = pj;
+    }
+
+    reverse(path.begin(), path.end());
+    reverse(path_maneuvers.begin(), path_maneuvers.end());
+    reverse(seg_times.begin(), seg_times.end());
+    reverse(seg_fuels.begin(), seg_fuels.end());
+
+    trajectory.path = path;
+    trajectory.maneuvers = path_maneuvers;
+    trajectory.segment_times = seg_times;
+    trajectory.segment_fuels = seg_fuels;
+    trajectory.avg_vy = (H_FINISH - H_START) / trajectory.total_time;
+
+    return trajectory;
+}
+
+void compare_solvers() {
+    OptimizationCriterion criteria[] = { MIN_TIME, MIN_FUEL };
+    string names[] = { "min_time", "min_fuel" };
+
+    for (int c = 0; c < 2; c++) {
+        TrajectoryResult dense = solve_trajectory(criteria[c], names[c]);
+
+        SearchStats stats;
+        TrajectoryResult best_first = solve_trajectory_astar(criteria[c], names[c], N, stats);
+
+        cout << "\nDense DP vs A* (" << names[c] << ", " << N << "x" << N << " grid)\n";
+        cout << "Dense DP: time " << dense.total_time << " s, fuel " << dense.total_fuel << " kg\n";
+        cout << "A*:       time " << best_first.total_time << " s, fuel " << best_first.total_fuel << " kg\n";
+        cout << "Edges evaluated: " << stats.edges_evaluated << " of " << stats.edges_total
+            << " (" << 100.0 * stats.edges_evaluated / stats.edges_total << "%)\n";
+    }
+
+    int large_n = 400;
+    for (int c = 0; c < 2; c++) {
+        SearchStats stats;
+        auto t0 = chrono::steady_clock::now();
+        TrajectoryResult best_first = solve_trajectory_astar(criteria[c], names[c], large_n, stats);
+        auto t1 = chrono::steady_clock::now();
+
+        cout << "\nA* (" << names[c] << ", " << large_n << "x" << large_n << " grid)\n";
+        cout << "Time " << best_first.total_time << " s, fuel " << best_first.total_fuel << " kg\n";
+        cout << "Edges evaluated: " << stats.edges_evaluated << " of " << stats.edges_total
+            << " (" << 100.0 * stats.edges_evaluated / stats.edges_total << "%), "
+            << chrono::duration<double>(t1 - t0).count() << " s\n";
+    }
+}
+
 int main() {
     cout << fixed << setprecision(2);
 
@@ -703,12 +992,16 @@ int main() {
     cout << "Finish: H = " << H_FINISH << " m, V = " << V_FINISH_KMH << " km/h\n";
     cout << "=================================================\n\n";
 
+    init_atmosphere();
+
     int choice;
     cout << "Select optimization criterion:\n";
     cout << "1 - Minimize time\n";
     cout << "2 - Minimize fuel consumption\n";
     cout << "3 - Compare both criteria\n";
-    cout << "Your choice (1, 2 or 3): ";
+    cout << "4 - Benchmark atmosphere lookup\n";
+    cout << "5 - Compare dense DP with A* search\n";
+    cout << "Your choice (1-5): ";
     cin >> choice;
 
     if (choice == 1) {
@@ -721,6 +1014,12 @@ int main() {
         TrajectoryResult traj_time = solve_trajectory(MIN_TIME, "min_time");
         TrajectoryResult traj_fuel = solve_trajectory(MIN_FUEL, "min_fuel");
     }
+    else if (choice == 4) {
+        benchmark_atmosphere();
+    }
+    else if (choice == 5) {
+        compare_solvers();
+    }
     else {
         cout << "\nInvalid choice!\n";
     }